@@ -1,7 +1,20 @@
+#define _POSIX_C_SOURCE 200809L
+#include <limits.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
 
 #define WINDOW_HEIGHT 720
 #define WINDOW_WIDTH 720
@@ -12,6 +25,37 @@
 #define PLAYER_SPEED 600.0f
 #define MAX_POWERUPS 10
 #define DROP_CHANCE 0.3f
+#define SIM_SUBSTEP (1.0f / 240.0f)
+#define MAX_INPUT_EVENTS 64
+#define MAX_BLOCKS 64
+#define IMPACT_EPSILON 1e-4f
+#define MAX_MATCH_SECONDS 600.0f
+#define MAX_TRAJECTORY_BOUNCES 8
+#define AUTOPLAY_DEADZONE 8.0f
+#define AUTOPLAY_LAUNCH_DELAY 0.5
+#define TELEMETRY_CAPACITY 4096
+#define AUDIO_SAMPLE_RATE 44100
+#define AUDIO_BLOCK_FRAMES 256
+#define MAX_SOUND_FRAMES (AUDIO_SAMPLE_RATE / 8)
+#define MAX_VOICES 16
+#define SOUND_COMMAND_CAPACITY 64
+#define LIMITER_THRESHOLD 0.8f
+#define LIMITER_RELEASE 0.0002f
+#define POWERUP_TYPE_COUNT 5
+#define TIMER_TICK 0.01
+#define TIMER_SLOTS 64
+#define TIMER_LEVELS 2
+#define MAX_TIMERS 128
+#define WIDE_PADDLE_BONUS (TILE_WIDTH / 2)
+#define MAX_PADDLE_WIDTH (TILE_WIDTH * 9)
+#define SLOW_BALL_FACTOR 0.7f
+#define FRAME_BUDGET (1.0f / 60.0f)
+#define MIN_RENDER_SCALE 0.5f
+#define RENDER_SCALE_STEP 0.05f
+#define RENDER_SCALE_COOLDOWN 15
+#define CAPTURE_RING_SIZE 8
+#define CAPTURE_WORKERS 4
+#define CAPTURE_READBACKS 3
 
 typedef enum {
     GAME_START,
@@ -20,35 +64,49 @@ typedef enum {
     GAME_WON
   } GameState;
 
+typedef enum {
+    EFFECT_WIDE_PADDLE,
+    EFFECT_SLOW_BALL,
+    EFFECT_STICKY_PADDLE,
+    EFFECT_MULTI_HIT,
+    EFFECT_COUNT
+} TimedEffect;
 
 typedef struct {
     Vector2 position;
     Vector2 velocity;
     bool isActive;
-} Entity;
-
-typedef struct {
-    Entity base;
     float speed;
     float radius;
+    int effectStacks[EFFECT_COUNT];
 } Ball;
 
 typedef struct {
-    Entity base;
+    Vector2 position;
+    Vector2 velocity;
     float width;
+    float baseWidth;
     float height;
     int lives;
+    int effectStacks[EFFECT_COUNT];
 } Player;
 
+// Live blocks are packed at the front of each array and destroying one moves the last live
+// block into its slot, so systems walk [0, count) without checking for dead entries.
 typedef struct {
-    Entity base;
-    int type;
-} Block;
+    Vector2 positions[MAX_BLOCKS];
+    int types[MAX_BLOCKS];
+    int cells[MAX_BLOCKS];
+    int slots[MAX_BLOCKS];
+    int count;
+} BlockSet;
 
 typedef struct {
-    Entity base;
-    int type;
-} PowerUp;
+    Vector2 positions[MAX_POWERUPS];
+    Vector2 velocities[MAX_POWERUPS];
+    int types[MAX_POWERUPS];
+    int count;
+} PowerUpSet;
 typedef struct {
     float width;
     float height;
@@ -56,14 +114,229 @@ typedef struct {
     Color backColor;
     Color frontColor;
 }  LifeBar;
+
+typedef enum {
+    INPUT_PADDLE_DIRECTION,
+    INPUT_LAUNCH
+} InputEventType;
+
+// time is the estimated event time on the simulation clock; pollTime is the wall-clock time the
+// event was polled (0 for events the game generates itself) and pollWait the estimated delay
+// between the event and that poll.
+typedef struct {
+    double time;
+    InputEventType type;
+    float direction;
+    Vector2 mousePosition;
+    double pollTime;
+    float pollWait;
+} InputEvent;
+
+typedef struct {
+    InputEvent events[MAX_INPUT_EVENTS];
+    int head;
+    int count;
+    float paddleDirection;
+} InputQueue;
+
+typedef struct {
+    double pendingPollTime;
+    float pendingWait;
+    float lastWait;
+    double lastLatency;
+    double totalLatency;
+    double maxLatency;
+    int samples;
+    bool showOverlay;
+} LatencyStats;
+
+typedef struct {
+    Vector2 points[MAX_TRAJECTORY_BOUNCES + 2];
+    int pointCount;
+    bool lands;
+    float landingX;
+    Vector2 origin;
+    Vector2 velocity;
+    unsigned int gridVersion;
+    bool passesBlocks;
+    bool valid;
+} Trajectory;
+
+typedef struct {
+    bool enabled;
+    float targetX;
+} Autoplay;
+
 typedef struct {
     Player player;
     Ball ball;
-    Block *blocks;
-    PowerUp powerUps[MAX_POWERUPS];
+    BlockSet blocks;
+    PowerUpSet powerUps;
     int rowCount;
     int columnCount;
+    InputQueue input;
+    LatencyStats latency;
+    Trajectory trajectory;
+    Autoplay autoplay;
 } GameStateData;
+
+typedef enum {
+    IMPACT_NONE,
+    IMPACT_WALL,
+    IMPACT_PLAYER,
+    IMPACT_BLOCK,
+    IMPACT_LOSS,
+    IMPACT_POWERUP_PICKUP,
+    IMPACT_POWERUP_MISSED,
+    IMPACT_PLAYER_WALL,
+    IMPACT_INPUT,
+    IMPACT_AUTOPLAY_TARGET,
+    IMPACT_EFFECT_EXPIRY
+} ImpactType;
+
+typedef struct {
+    float time;
+    ImpactType type;
+    int index;
+} Impact;
+
+typedef struct {
+    int matchesWon;
+    int matchesLost;
+    int matchesUnfinished;
+    int blocksDestroyed;
+    long long eventsProcessed;
+    double simulatedSeconds;
+} SimulationReport;
+typedef enum {
+    TELEMETRY_FRAME,
+    TELEMETRY_BLOCK_DESTROYED,
+    TELEMETRY_BALL_SPEED,
+    TELEMETRY_POWERUP_SPAWNED,
+    TELEMETRY_POWERUP_PICKED_UP,
+    TELEMETRY_LIFE_LOST
+} TelemetryType;
+
+typedef struct {
+    double time;
+    float value;
+    int type;
+} TelemetryRecord;
+
+// Single-producer ring: only the game thread advances head, only the writer thread advances tail.
+// The live loop drops records when the ring is full; lossless (headless) runs wait for the writer.
+typedef struct {
+    TelemetryRecord records[TELEMETRY_CAPACITY];
+    _Atomic unsigned int head;
+    _Atomic unsigned int tail;
+    _Atomic unsigned int dropped;
+    _Atomic bool running;
+    bool enabled;
+    bool lossless;
+    FILE *file;
+    pthread_t writer;
+} Telemetry;
+
+typedef enum {
+    SOUND_BLOCK_BREAK,
+    SOUND_PADDLE_HIT,
+    SOUND_COUNT
+} SoundId;
+
+typedef enum {
+    AUDIO_BACKEND_NONE,
+    AUDIO_BACKEND_DEVICE,
+    AUDIO_BACKEND_NULL,
+    AUDIO_BACKEND_WAV
+} AudioBackend;
+
+typedef struct {
+    double time;
+    float gain;
+    int sound;
+} SoundCommand;
+
+typedef struct {
+    int sound;
+    int cursor;
+    int delay;
+    float gain;
+    bool active;
+} Voice;
+
+// Voices and the limiter belong to whichever thread mixes (the device callback, or the game
+// thread for the offline backends); the game thread only ever touches the command ring.
+typedef struct {
+    AudioBackend backend;
+    float sounds[SOUND_COUNT][MAX_SOUND_FRAMES];
+    int soundFrames[SOUND_COUNT];
+    SoundCommand commands[SOUND_COMMAND_CAPACITY];
+    _Atomic unsigned int commandHead;
+    _Atomic unsigned int commandTail;
+    Voice voices[MAX_VOICES];
+    float limiterGain;
+    long long renderedFrames;
+    AudioStream stream;
+    FILE *wavFile;
+} AudioMixer;
+
+typedef struct {
+    Player *player;
+    Ball *ball;
+    TimedEffect effect;
+    unsigned long long expiryTick;
+    int next;
+} Timer;
+
+typedef struct {
+    Timer timers[MAX_TIMERS];
+    int slots[TIMER_LEVELS][TIMER_SLOTS];
+    int freeList;
+    int activeCount;
+    unsigned long long currentTick;
+} TimerWheel;
+
+typedef struct {
+    RenderTexture2D target;
+    float scale;
+    float frameBudget;
+    double renderStart;
+    float smoothedScene;
+    float smoothedRender;
+    float smoothedWork;
+    int cooldown;
+    bool enabled;
+} ResolutionScaler;
+
+typedef struct {
+    unsigned char *buffers[CAPTURE_RING_SIZE];
+    int freeCount;
+    unsigned char *pixels[CAPTURE_RING_SIZE];
+    int frameIndices[CAPTURE_RING_SIZE];
+    int head;
+    int count;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    pthread_cond_t space;
+    pthread_t workers[CAPTURE_WORKERS];
+    int workerCount;
+    bool running;
+    bool enabled;
+    bool lossless;
+    _Atomic bool failed;
+    bool asyncReadback;
+    GLuint readbacks[CAPTURE_READBACKS];
+    GLsync fences[CAPTURE_READBACKS];
+    int readbackHead;
+    int readbackCount;
+    int width;
+    int height;
+    int capturedFrames;
+    int droppedFrames;
+    const char *directory;
+    FILE *video;
+} FrameCapture;
+
 LifeBar getLifeBar = {
     .width     = 200.0f,
     .height    = 20.0f,
@@ -73,25 +346,447 @@ LifeBar getLifeBar = {
   };
 
 GameState game_state = GAME_START;
-PowerUp powerUps[MAX_POWERUPS] = {0};
-typedef void (*PowerUpEffect)(Player *player);
+unsigned int blockGridVersion = 0;
+Telemetry telemetry = {0};
+AudioMixer audio = {0};
+double gameClock = 0.0;
+FrameCapture capture = {0};
+TimerWheel effectTimers;
+
+float timedEffectDurations[EFFECT_COUNT] = {
+    10.0f,
+    8.0f,
+    10.0f,
+    6.0f
+};
+
+const char *telemetryTypeNames[] = {
+    "frame",
+    "block_destroyed",
+    "ball_speed",
+    "powerup_spawned",
+    "powerup_picked_up",
+    "life_lost"
+};
+
+// Never allocates. In the live loop a full ring drops the record and counts it; lossless
+// (headless) runs instead wait for the writer to free a slot.
+void PushTelemetry(TelemetryType type, float value) {
+    if (!telemetry.enabled) return;
+    unsigned int head = atomic_load_explicit(&telemetry.head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&telemetry.tail, memory_order_acquire);
+    struct timespec wait = {0, 100000};
+    while (telemetry.lossless && head - tail == TELEMETRY_CAPACITY) {
+        nanosleep(&wait, NULL);
+        tail = atomic_load_explicit(&telemetry.tail, memory_order_acquire);
+    }
+    if (head - tail == TELEMETRY_CAPACITY) {
+        atomic_fetch_add_explicit(&telemetry.dropped, 1, memory_order_relaxed);
+        return;
+    }
+    telemetry.records[head % TELEMETRY_CAPACITY] = (TelemetryRecord){gameClock, value, type};
+    atomic_store_explicit(&telemetry.head, head + 1, memory_order_release);
+}
+
+void DrainTelemetry(void) {
+    unsigned int tail = atomic_load_explicit(&telemetry.tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&telemetry.head, memory_order_acquire);
+    while (tail != head) {
+        TelemetryRecord *record = &telemetry.records[tail % TELEMETRY_CAPACITY];
+        fprintf(telemetry.file, "%.6f,%s,%g\n", record->time, telemetryTypeNames[record->type], record->value);
+        tail++;
+    }
+    atomic_store_explicit(&telemetry.tail, tail, memory_order_release);
+}
+
+void *TelemetryWriterMain(void *argument) {
+    (void)argument;
+    struct timespec idle = {0, 5000000};
+    while (atomic_load_explicit(&telemetry.running, memory_order_acquire)) {
+        DrainTelemetry();
+        nanosleep(&idle, NULL);
+    }
+    DrainTelemetry();
+    return NULL;
+}
+
+bool StartTelemetry(const char *path) {
+    telemetry.file = fopen(path, "w");
+    if (telemetry.file == NULL) return false;
+    fprintf(telemetry.file, "time,event,value\n");
+    atomic_store(&telemetry.running, true);
+    if (pthread_create(&telemetry.writer, NULL, TelemetryWriterMain, NULL) != 0) {
+        atomic_store(&telemetry.running, false);
+        fclose(telemetry.file);
+        return false;
+    }
+    telemetry.enabled = true;
+    return true;
+}
+
+void StopTelemetry(void) {
+    if (!telemetry.enabled) return;
+    telemetry.enabled = false;
+    atomic_store_explicit(&telemetry.running, false, memory_order_release);
+    pthread_join(telemetry.writer, NULL);
+    unsigned int dropped = atomic_load(&telemetry.dropped);
+    if (dropped > 0) fprintf(telemetry.file, "# dropped %u records\n", dropped);
+    fclose(telemetry.file);
+}
+
+void SynthesizeSound(SoundId sound, float frequency, float noise, float duration) {
+    unsigned int seed = 1u + sound;
+    int frames = (int)(duration * AUDIO_SAMPLE_RATE);
+    for (int i = 0; i < frames; i++) {
+        float t = (float)i / AUDIO_SAMPLE_RATE;
+        seed = seed * 1664525u + 1013904223u;
+        float white = (float)(seed >> 8) / (float)(1u << 24) * 2.0f - 1.0f;
+        float tone = sinf(2.0f * PI * frequency * t);
+        audio.sounds[sound][i] = ((1.0f - noise) * tone + noise * white) * expf(-t * 40.0f);
+    }
+    audio.soundFrames[sound] = frames;
+}
+
+void PlaySoundEffect(SoundId sound, float gain) {
+    if (audio.backend == AUDIO_BACKEND_NONE) return;
+    unsigned int head = atomic_load_explicit(&audio.commandHead, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&audio.commandTail, memory_order_acquire);
+    if (head - tail == SOUND_COMMAND_CAPACITY) return;
+    audio.commands[head % SOUND_COMMAND_CAPACITY] = (SoundCommand){gameClock, gain, sound};
+    atomic_store_explicit(&audio.commandHead, head + 1, memory_order_release);
+}
+
+// Takes a free voice, or steals the one with the fewest frames left to play.
+Voice *AllocateVoice(void) {
+    Voice *stolen = &audio.voices[0];
+    int stolenRemaining = INT_MAX;
+    for (int i = 0; i < MAX_VOICES; i++) {
+        Voice *voice = &audio.voices[i];
+        if (!voice->active) return voice;
+        int remaining = voice->delay + audio.soundFrames[voice->sound] - voice->cursor;
+        if (remaining < stolenRemaining) {
+            stolen = voice;
+            stolenRemaining = remaining;
+        }
+    }
+    return stolen;
+}
+
+void StartQueuedVoices(bool scheduled) {
+    unsigned int tail = atomic_load_explicit(&audio.commandTail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&audio.commandHead, memory_order_acquire);
+    while (tail != head) {
+        SoundCommand *command = &audio.commands[tail % SOUND_COMMAND_CAPACITY];
+        Voice *voice = AllocateVoice();
+        *voice = (Voice){command->sound, 0, 0, command->gain, true};
+        if (scheduled) {
+            long long startFrame = (long long)(command->time * AUDIO_SAMPLE_RATE);
+            if (startFrame > audio.renderedFrames) voice->delay = (int)(startFrame - audio.renderedFrames);
+        }
+        tail++;
+    }
+    atomic_store_explicit(&audio.commandTail, tail, memory_order_release);
+}
+
+// Mixes one block without locks or allocation. Offline backends start voices at their
+// game-clock timestamp (scheduled); the device starts them at the next callback.
+void MixAudio(short *output, int frames, bool scheduled) {
+    float mix[AUDIO_BLOCK_FRAMES];
+    StartQueuedVoices(scheduled);
+    for (int i = 0; i < frames; i++) mix[i] = 0.0f;
+    for (int v = 0; v < MAX_VOICES; v++) {
+        Voice *voice = &audio.voices[v];
+        if (!voice->active) continue;
+        int start = voice->delay < frames ? voice->delay : frames;
+        voice->delay -= start;
+        float *samples = audio.sounds[voice->sound];
+        for (int i = start; i < frames && voice->cursor < audio.soundFrames[voice->sound]; i++) {
+            mix[i] += samples[voice->cursor++] * voice->gain;
+        }
+        if (voice->cursor >= audio.soundFrames[voice->sound]) voice->active = false;
+    }
+    for (int i = 0; i < frames; i++) {
+        float level = fabsf(mix[i] * audio.limiterGain);
+        if (level > LIMITER_THRESHOLD) audio.limiterGain = LIMITER_THRESHOLD / fabsf(mix[i]);
+        else audio.limiterGain += (1.0f - audio.limiterGain) * LIMITER_RELEASE;
+        output[i] = (short)(mix[i] * audio.limiterGain * 32767.0f);
+    }
+    audio.renderedFrames += frames;
+}
 
-void PowerUpExtraLife(Player *player) {
+void AudioDeviceCallback(void *buffer, unsigned int frames) {
+    short *output = buffer;
+    while (frames > 0) {
+        int block = frames < AUDIO_BLOCK_FRAMES ? (int)frames : AUDIO_BLOCK_FRAMES;
+        MixAudio(output, block, false);
+        output += block;
+        frames -= block;
+    }
+}
+
+void WriteWavHeader(FILE *file, unsigned int dataBytes) {
+    unsigned int riffBytes = 36 + dataBytes;
+    unsigned int formatBytes = 16;
+    unsigned short format = 1;
+    unsigned short channels = 1;
+    unsigned int sampleRate = AUDIO_SAMPLE_RATE;
+    unsigned int byteRate = AUDIO_SAMPLE_RATE * sizeof(short);
+    unsigned short blockAlign = sizeof(short);
+    unsigned short bitsPerSample = 16;
+    fwrite("RIFF", 1, 4, file);
+    fwrite(&riffBytes, 4, 1, file);
+    fwrite("WAVEfmt ", 1, 8, file);
+    fwrite(&formatBytes, 4, 1, file);
+    fwrite(&format, 2, 1, file);
+    fwrite(&channels, 2, 1, file);
+    fwrite(&sampleRate, 4, 1, file);
+    fwrite(&byteRate, 4, 1, file);
+    fwrite(&blockAlign, 2, 1, file);
+    fwrite(&bitsPerSample, 2, 1, file);
+    fwrite("data", 1, 4, file);
+    fwrite(&dataBytes, 4, 1, file);
+}
+
+// Renders the offline backends up to the given game-clock time; the device pulls its own audio.
+void PumpAudio(double time) {
+    if (audio.backend != AUDIO_BACKEND_NULL && audio.backend != AUDIO_BACKEND_WAV) return;
+    short block[AUDIO_BLOCK_FRAMES];
+    long long targetFrames = (long long)(time * AUDIO_SAMPLE_RATE);
+    while (audio.renderedFrames < targetFrames) {
+        long long remaining = targetFrames - audio.renderedFrames;
+        int frames = remaining < AUDIO_BLOCK_FRAMES ? (int)remaining : AUDIO_BLOCK_FRAMES;
+        MixAudio(block, frames, true);
+        if (audio.wavFile != NULL) fwrite(block, sizeof(short), frames, audio.wavFile);
+    }
+}
+
+bool StartAudio(AudioBackend backend, const char *wavPath) {
+    SynthesizeSound(SOUND_BLOCK_BREAK, 880.0f, 0.4f, 0.12f);
+    SynthesizeSound(SOUND_PADDLE_HIT, 220.0f, 0.1f, 0.08f);
+    audio.limiterGain = 1.0f;
+    audio.renderedFrames = (long long)(gameClock * AUDIO_SAMPLE_RATE);
+    if (backend == AUDIO_BACKEND_DEVICE) {
+        InitAudioDevice();
+        if (IsAudioDeviceReady()) {
+            SetAudioStreamBufferSizeDefault(AUDIO_BLOCK_FRAMES * 4);
+            audio.stream = LoadAudioStream(AUDIO_SAMPLE_RATE, 16, 1);
+            SetAudioStreamCallback(audio.stream, AudioDeviceCallback);
+            PlayAudioStream(audio.stream);
+        } else {
+            CloseAudioDevice();
+            backend = AUDIO_BACKEND_NULL;
+        }
+    } else if (backend == AUDIO_BACKEND_WAV) {
+        audio.wavFile = fopen(wavPath, "wb");
+        if (audio.wavFile == NULL) return false;
+        WriteWavHeader(audio.wavFile, 0);
+    }
+    audio.backend = backend;
+    return true;
+}
+
+void StopAudio(void) {
+    if (audio.backend == AUDIO_BACKEND_DEVICE) {
+        StopAudioStream(audio.stream);
+        UnloadAudioStream(audio.stream);
+        CloseAudioDevice();
+    } else if (audio.backend == AUDIO_BACKEND_WAV) {
+        long dataBytes = ftell(audio.wavFile) - 44;
+        fseek(audio.wavFile, 0, SEEK_SET);
+        WriteWavHeader(audio.wavFile, (unsigned int)dataBytes);
+        fclose(audio.wavFile);
+    }
+    audio.backend = AUDIO_BACKEND_NONE;
+}
+
+void ClearTimers(TimerWheel *wheel) {
+    for (int level = 0; level < TIMER_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_SLOTS; slot++) wheel->slots[level][slot] = -1;
+    }
+    for (int i = 0; i < MAX_TIMERS; i++) wheel->timers[i].next = i + 1 < MAX_TIMERS ? i + 1 : -1;
+    wheel->freeList = 0;
+    wheel->activeCount = 0;
+    wheel->currentTick = (unsigned long long)(gameClock / TIMER_TICK);
+}
+
+// Timers due within TIMER_SLOTS ticks go to the fine level; later ones wait in a coarse slot
+// and are re-inserted when their block comes up. Anything past the coarse range parks in the
+// furthest coarse slot and is re-inserted from there.
+void InsertTimer(TimerWheel *wheel, int index) {
+    Timer *timer = &wheel->timers[index];
+    unsigned long long delta = timer->expiryTick - wheel->currentTick;
+    int *slot;
+    if (delta < TIMER_SLOTS) {
+        slot = &wheel->slots[0][timer->expiryTick % TIMER_SLOTS];
+    } else if (delta < (unsigned long long)TIMER_SLOTS * (TIMER_SLOTS - 1)) {
+        slot = &wheel->slots[1][(timer->expiryTick / TIMER_SLOTS) % TIMER_SLOTS];
+    } else {
+        slot = &wheel->slots[1][(wheel->currentTick / TIMER_SLOTS + TIMER_SLOTS - 1) % TIMER_SLOTS];
+    }
+    timer->next = *slot;
+    *slot = index;
+}
+
+bool ScheduleTimer(TimerWheel *wheel, Player *player, Ball *ball, TimedEffect effect, float duration) {
+    if (wheel->freeList < 0) return false;
+    int index = wheel->freeList;
+    Timer *timer = &wheel->timers[index];
+    wheel->freeList = timer->next;
+    unsigned long long ticks = (unsigned long long)(duration / TIMER_TICK + 0.5);
+    *timer = (Timer){player, ball, effect, wheel->currentTick + (ticks > 0 ? ticks : 1), -1};
+    InsertTimer(wheel, index);
+    wheel->activeCount++;
+    return true;
+}
+
+void RemoveTimedEffect(Player *player, Ball *ball, TimedEffect effect);
+
+// Each tick touches one fine slot, plus one coarse slot every TIMER_SLOTS ticks.
+void AdvanceTimers(TimerWheel *wheel, double time) {
+    unsigned long long targetTick = (unsigned long long)(time / TIMER_TICK);
+    if (wheel->activeCount == 0 && targetTick > wheel->currentTick) wheel->currentTick = targetTick;
+    while (wheel->currentTick < targetTick) {
+        wheel->currentTick++;
+        if (wheel->currentTick % TIMER_SLOTS == 0) {
+            int *coarse = &wheel->slots[1][(wheel->currentTick / TIMER_SLOTS) % TIMER_SLOTS];
+            int index = *coarse;
+            *coarse = -1;
+            while (index >= 0) {
+                int next = wheel->timers[index].next;
+                InsertTimer(wheel, index);
+                index = next;
+            }
+        }
+        int *fine = &wheel->slots[0][wheel->currentTick % TIMER_SLOTS];
+        int index = *fine;
+        *fine = -1;
+        while (index >= 0) {
+            Timer *timer = &wheel->timers[index];
+            int next = timer->next;
+            RemoveTimedEffect(timer->player, timer->ball, timer->effect);
+            timer->next = wheel->freeList;
+            wheel->freeList = index;
+            wheel->activeCount--;
+            index = next;
+        }
+    }
+}
+
+// Earliest pending expiry, or -1 when nothing is scheduled; lets the event-driven simulator
+// treat expirations as impacts.
+double GetNextTimerExpiry(TimerWheel *wheel) {
+    if (wheel->activeCount == 0) return -1.0;
+    unsigned long long earliest = ULLONG_MAX;
+    for (unsigned long long tick = wheel->currentTick + 1; tick < wheel->currentTick + TIMER_SLOTS; tick++) {
+        if (wheel->slots[0][tick % TIMER_SLOTS] >= 0) {
+            earliest = tick;
+            break;
+        }
+    }
+    unsigned long long block = wheel->currentTick / TIMER_SLOTS + 1;
+    for (int i = 0; i < TIMER_SLOTS; i++, block++) {
+        int index = wheel->slots[1][block % TIMER_SLOTS];
+        if (index < 0) continue;
+        for (; index >= 0; index = wheel->timers[index].next) {
+            unsigned long long expiryTick = wheel->timers[index].expiryTick;
+            if (expiryTick < earliest) earliest = expiryTick;
+        }
+        break;
+    }
+    return earliest == ULLONG_MAX ? -1.0 : earliest * TIMER_TICK;
+}
+
+float GetBallSpeedScale(Ball *ball) {
+    return powf(SLOW_BALL_FACTOR, ball->effectStacks[EFFECT_SLOW_BALL]);
+}
+
+void RefreshPaddleWidth(Player *player) {
+    float center = player->position.x + player->width / 2;
+    player->width = fminf(player->baseWidth + player->effectStacks[EFFECT_WIDE_PADDLE] * WIDE_PADDLE_BONUS, MAX_PADDLE_WIDTH);
+    player->position.x = Clamp(center - player->width / 2, 0, WINDOW_WIDTH - player->width);
+}
+
+void ApplyTimedEffect(Player *player, Ball *ball, TimedEffect effect) {
+    if (!ScheduleTimer(&effectTimers, player, ball, effect, timedEffectDurations[effect])) return;
+    switch (effect) {
+        case EFFECT_WIDE_PADDLE:
+            player->effectStacks[effect]++;
+            RefreshPaddleWidth(player);
+            break;
+        case EFFECT_STICKY_PADDLE:
+            player->effectStacks[effect]++;
+            break;
+        case EFFECT_SLOW_BALL:
+            ball->effectStacks[effect]++;
+            ball->speed *= SLOW_BALL_FACTOR;
+            ball->velocity = Vector2Scale(ball->velocity, SLOW_BALL_FACTOR);
+            break;
+        case EFFECT_MULTI_HIT:
+            ball->effectStacks[effect]++;
+            break;
+        default:
+            break;
+    }
+}
+
+void RemoveTimedEffect(Player *player, Ball *ball, TimedEffect effect) {
+    switch (effect) {
+        case EFFECT_WIDE_PADDLE:
+            player->effectStacks[effect]--;
+            RefreshPaddleWidth(player);
+            break;
+        case EFFECT_STICKY_PADDLE:
+            player->effectStacks[effect]--;
+            break;
+        case EFFECT_SLOW_BALL:
+            ball->effectStacks[effect]--;
+            ball->speed /= SLOW_BALL_FACTOR;
+            ball->velocity = Vector2Scale(ball->velocity, 1.0f / SLOW_BALL_FACTOR);
+            break;
+        case EFFECT_MULTI_HIT:
+            ball->effectStacks[effect]--;
+            break;
+        default:
+            break;
+    }
+}
+
+typedef void (*PowerUpEffect)(Player *player, Ball *ball);
+
+void PowerUpExtraLife(Player *player, Ball *ball) {
+    (void)ball;
     player->lives++;
 }
 
-void PowerUpIncreasePaddleWidth(Player *player) {
-    player->width += TILE_WIDTH / 2;
+void PowerUpIncreasePaddleWidth(Player *player, Ball *ball) {
+    ApplyTimedEffect(player, ball, EFFECT_WIDE_PADDLE);
+}
+
+void PowerUpSlowBall(Player *player, Ball *ball) {
+    ApplyTimedEffect(player, ball, EFFECT_SLOW_BALL);
+}
+
+void PowerUpStickyPaddle(Player *player, Ball *ball) {
+    ApplyTimedEffect(player, ball, EFFECT_STICKY_PADDLE);
+}
+
+void PowerUpMultiHitBall(Player *player, Ball *ball) {
+    ApplyTimedEffect(player, ball, EFFECT_MULTI_HIT);
 }
 
-PowerUpEffect powerUpEffects[] = {
+PowerUpEffect powerUpEffects[POWERUP_TYPE_COUNT] = {
     PowerUpExtraLife,
-    PowerUpIncreasePaddleWidth
+    PowerUpIncreasePaddleWidth,
+    PowerUpSlowBall,
+    PowerUpStickyPaddle,
+    PowerUpMultiHitBall
 };
 
+Color powerUpColors[POWERUP_TYPE_COUNT] = {GREEN, PURPLE, SKYBLUE, YELLOW, ORANGE};
+
 Vector2 ReflectBall(Ball *ball, Player *player) {
-    float playerVelocityX = player->base.velocity.x;
-    float offset = (ball->base.position.x - player->base.position.x) / player->width - 0.5f;
+    float playerVelocityX = player->velocity.x;
+    float offset = (ball->position.x - player->position.x) / player->width - 0.5f;
     Vector2 direction = {offset + playerVelocityX / PLAYER_SPEED, -1.0f};
     Vector2 reflectedVelocity = Vector2Scale(Vector2Normalize(direction), ball->speed);
     ball->speed *= 1.05f;
@@ -100,63 +795,62 @@ Vector2 ReflectBall(Ball *ball, Player *player) {
 
 
 
-void DropPowerUp(Block *block, PowerUp *powerUps) {
-    if (GetRandomValue(0, 100) < DROP_CHANCE * 100) {
-        for (int i = 0; i < MAX_POWERUPS; i++) {
-            if (!powerUps[i].base.isActive) {
-                powerUps[i].base.position = (Vector2){
-                    block->base.position.x + BLOCK_SIZE / 2,
-                    block->base.position.y + TILE_HEIGHT / 2
-                };
-                powerUps[i].base.velocity = (Vector2){0, 100.0f};
-                powerUps[i].type = GetRandomValue(0, 1);
-                powerUps[i].base.isActive = true;
-                break;
-            }
-        }
+void DropPowerUp(Vector2 blockPosition, PowerUpSet *powerUps) {
+    if (GetRandomValue(0, 100) < DROP_CHANCE * 100 && powerUps->count < MAX_POWERUPS) {
+        int slot = powerUps->count++;
+        powerUps->positions[slot] = (Vector2){blockPosition.x + BLOCK_SIZE / 2, blockPosition.y + TILE_HEIGHT / 2};
+        powerUps->velocities[slot] = (Vector2){0, 100.0f};
+        powerUps->types[slot] = GetRandomValue(0, POWERUP_TYPE_COUNT - 1);
+        PushTelemetry(TELEMETRY_POWERUP_SPAWNED, powerUps->types[slot]);
     }
 }
 
-void UpdatePowerUps(PowerUp *powerUps, int maxPowerUps, float deltaTime) {
-    for (int i = 0; i < maxPowerUps; i++) {
-        if (powerUps[i].base.isActive) {
-            powerUps[i].base.position.y += powerUps[i].base.velocity.y * deltaTime;
-            if (powerUps[i].base.position.y > WINDOW_HEIGHT) {
-                powerUps[i].base.isActive = false;
-            }
-        }
+void RemovePowerUp(PowerUpSet *powerUps, int slot) {
+    int last = --powerUps->count;
+    powerUps->positions[slot] = powerUps->positions[last];
+    powerUps->velocities[slot] = powerUps->velocities[last];
+    powerUps->types[slot] = powerUps->types[last];
+}
+
+void MovePowerUps(PowerUpSet *powerUps, float deltaTime) {
+    for (int i = 0; i < powerUps->count; i++) {
+        powerUps->positions[i].y += powerUps->velocities[i].y * deltaTime;
+    }
+}
+
+void RemoveMissedPowerUps(PowerUpSet *powerUps) {
+    for (int i = powerUps->count - 1; i >= 0; i--) {
+        if (powerUps->positions[i].y > WINDOW_HEIGHT) RemovePowerUp(powerUps, i);
     }
 }
 
 void DrawPlayer(Player *player) {
-    DrawRectangle(player->base.position.x, player->base.position.y, player->width, player->height, PURPLE);
-    DrawRectangleLines(player->base.position.x, player->base.position.y, player->width, player->height, DARKPURPLE);
+    DrawRectangle(player->position.x, player->position.y, player->width, player->height, PURPLE);
+    DrawRectangleLines(player->position.x, player->position.y, player->width, player->height, DARKPURPLE);
 }
 
-void DrawBall(Ball *ball) {
-    DrawCircleV(ball->base.position, ball->radius, PINK);
-    if (!ball->base.isActive) {
-        Vector2 mousePosition = GetMousePosition();
-        Vector2 direction = Vector2Normalize(Vector2Subtract(mousePosition, ball->base.position));
-        Vector2 endPosition = Vector2Add(ball->base.position, Vector2Scale(direction, 40.0f));
-        DrawLineV(ball->base.position, endPosition, RED);
+void DrawBall(Ball *ball, Trajectory *trajectory) {
+    DrawCircleV(ball->position, ball->radius, PINK);
+    if (!ball->isActive && trajectory->valid) {
+        Vector2 start = ball->position;
+        for (int i = 1; i < trajectory->pointCount; i++) {
+            DrawLineV(start, trajectory->points[i], RED);
+            start = trajectory->points[i];
+        }
     }
 }
 
-void DrawBlocks(Block *blocks, int rowCount, int columnCount) {
-    for (int rowIndex = 0; rowIndex < rowCount; rowIndex++) {
-        for (int columnIndex = 0; columnIndex < columnCount; columnIndex++) {
-            Block *block = &blocks[rowIndex * columnCount + columnIndex];
-            if (block->base.isActive) {
-                Color blockColor = (block->type == 0) ? WHITE : (block->type == 1) ? BLACK : BLUE;
-                DrawRectangle(columnIndex * BLOCK_SIZE, rowIndex * TILE_HEIGHT, BLOCK_SIZE, TILE_HEIGHT, blockColor);
-                DrawRectangleLines(columnIndex * BLOCK_SIZE, rowIndex * TILE_HEIGHT, BLOCK_SIZE, TILE_HEIGHT, PURPLE);
-            }
-        }
+void DrawBlocks(BlockSet *blocks) {
+    for (int i = 0; i < blocks->count; i++) {
+        Vector2 position = blocks->positions[i];
+        int type = blocks->types[i];
+        Color blockColor = (type == 0) ? WHITE : (type == 1) ? BLACK : BLUE;
+        DrawRectangle(position.x, position.y, BLOCK_SIZE, TILE_HEIGHT, blockColor);
+        DrawRectangleLines(position.x, position.y, BLOCK_SIZE, TILE_HEIGHT, PURPLE);
     }
 }
-void DrawPowerUp(PowerUp *powerUp) {
-    if (powerUp->base.isActive) DrawCircleV(powerUp->base.position, 10, GREEN);
+void DrawPowerUps(PowerUpSet *powerUps) {
+    for (int i = 0; i < powerUps->count; i++) DrawCircleV(powerUps->positions[i], 10, powerUpColors[powerUps->types[i]]);
 }
 
 void DrawLifebar(Player *player) {
@@ -186,215 +880,860 @@ void DrawWinScreen() {
 
 Player InitPlayer(Vector2 position) {
     Player player = {0};
-    player.base.position = position;
+    player.position = position;
     player.width = TILE_WIDTH * 5;
+    player.baseWidth = player.width;
     player.height = TILE_HEIGHT;
     player.lives = 3;
-    player.base.isActive = true;
     return player;
 }
 
 Ball InitBall(Vector2 position) {
     Ball ball = {0};
-    ball.base.position = position;
+    ball.position = position;
     ball.speed = BALL_SPEED;
     ball.radius = 16.0f;
     return ball;
 }
 
-Block InitBlock(Vector2 position, int type) {
-    Block block = {0};
-    block.base.position = position;
-    block.base.isActive = true;
-    block.type = type;
-    return block;
+void InitBlocks(BlockSet *blocks, int rowCount, int columnCount) {
+    blocks->count = 0;
+    for (int rowIndex = 0; rowIndex < rowCount; rowIndex++) {
+        for (int columnIndex = 0; columnIndex < columnCount; columnIndex++) {
+            int cell = rowIndex * columnCount + columnIndex;
+            int slot = blocks->count++;
+            blocks->positions[slot] = (Vector2){columnIndex * BLOCK_SIZE, rowIndex * TILE_HEIGHT};
+            blocks->types[slot] = rowIndex % 3;
+            blocks->cells[slot] = cell;
+            blocks->slots[cell] = slot;
+        }
+    }
 }
-void DrawGame(Player *player, Ball *ball, Block *blocks, int rowCount, int columnCount, PowerUp *powerUps) {
+void DrawGame(Player *player, Ball *ball, Trajectory *trajectory, BlockSet *blocks, PowerUpSet *powerUps) {
     ClearBackground(BLACK);
-    DrawBlocks(blocks, rowCount, columnCount);
+    DrawBlocks(blocks);
     DrawPlayer(player);
-    DrawBall(ball);
-    for (int i = 0; i < MAX_POWERUPS; i++) DrawPowerUp(&powerUps[i]);
-    DrawLifebar(player);
-}
-void DestroyBlock(Block *block, Ball *ball, PowerUp *powerUps, int rowCount, int columnCount) {
-    block->base.isActive = false;
-    ball->base.velocity.y = -ball->base.velocity.y;
-    DropPowerUp(block, powerUps);
-    bool allBlocksGone = true;
-    for (int i = 0; i < rowCount * columnCount; i++) {
-        if (block[i].base.isActive) {
-            allBlocksGone = false;
-            break;
+    DrawBall(ball, trajectory);
+    DrawPowerUps(powerUps);
+}
+
+ResolutionScaler InitResolutionScaler(bool enabled) {
+    ResolutionScaler scaler = {0};
+    scaler.target = LoadRenderTexture(WINDOW_WIDTH, WINDOW_HEIGHT);
+    SetTextureFilter(scaler.target.texture, TEXTURE_FILTER_BILINEAR);
+    scaler.scale = 1.0f;
+    scaler.frameBudget = FRAME_BUDGET;
+    scaler.smoothedRender = FRAME_BUDGET;
+    scaler.smoothedWork = FRAME_BUDGET;
+    scaler.enabled = enabled;
+    return scaler;
+}
+
+// Draws the playfield into the top-left scale x scale corner of the offscreen target, and starts
+// the render span that UpdateResolutionScale closes after EndDrawing.
+void DrawScaledGame(ResolutionScaler *scaler, GameStateData *gameData) {
+    scaler->renderStart = GetTime();
+    BeginTextureMode(scaler->target);
+    BeginMode2D((Camera2D){.zoom = scaler->scale});
+    DrawGame(&gameData->player, &gameData->ball, &gameData->trajectory, &gameData->blocks, &gameData->powerUps);
+    EndMode2D();
+    EndTextureMode();
+    scaler->smoothedScene += ((float)(GetTime() - scaler->renderStart) - scaler->smoothedScene) * 0.1f;
+}
+
+void PresentScaledGame(ResolutionScaler *scaler) {
+    float width = WINDOW_WIDTH * scaler->scale;
+    float height = WINDOW_HEIGHT * scaler->scale;
+    Rectangle source = {0, scaler->target.texture.height - height, width, -height};
+    Rectangle destination = {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
+    DrawTexturePro(scaler->target.texture, source, destination, (Vector2){0, 0}, 0.0f, WHITE);
+}
+
+// There is no GPU timer query in rlgl, so the cost is taken as the span from DrawScaledGame to the
+// return of EndDrawing, against a budget of one refresh of the current monitor. On a vsynced or
+// frame-capped display EndDrawing waits out the rest of the refresh, so an on-time frame spans at
+// most one budget and only a GPU that misses the vblank pushes it past; stalls in the simulation
+// happen before the span starts and do not count. Headroom is judged from the span minus the
+// present wait. Steps are small and rate-limited, and a step down waits longer before the next
+// step up, so the scale settles instead of oscillating.
+void UpdateResolutionScale(ResolutionScaler *scaler, double presentEnd, double presentTime) {
+    if (!scaler->enabled) return;
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    scaler->frameBudget = refreshRate > 0 ? 1.0f / refreshRate : FRAME_BUDGET;
+    float render = (float)(presentEnd - scaler->renderStart);
+    scaler->smoothedRender += (render - scaler->smoothedRender) * 0.1f;
+    scaler->smoothedWork += ((render - (float)presentTime) - scaler->smoothedWork) * 0.1f;
+    if (scaler->cooldown > 0) {
+        scaler->cooldown--;
+        return;
+    }
+    if (scaler->smoothedRender > scaler->frameBudget * 1.1f && scaler->scale > MIN_RENDER_SCALE) {
+        scaler->scale = fmaxf(scaler->scale - RENDER_SCALE_STEP, MIN_RENDER_SCALE);
+        scaler->cooldown = RENDER_SCALE_COOLDOWN * 4;
+    } else if (scaler->smoothedRender < scaler->frameBudget * 1.02f && scaler->smoothedWork < scaler->frameBudget * 0.6f &&
+               scaler->scale < 1.0f) {
+        scaler->scale = fminf(scaler->scale + RENDER_SCALE_STEP, 1.0f);
+        scaler->cooldown = RENDER_SCALE_COOLDOWN;
+    }
+}
+
+void DrawResolutionOverlay(ResolutionScaler *scaler) {
+    DrawText(TextFormat("render scale %d%%  scene %.1f ms  render %.1f / %.1f ms", (int)(scaler->scale * 100.0f + 0.5f),
+                        scaler->smoothedScene * 1000.0f, scaler->smoothedRender * 1000.0f, scaler->frameBudget * 1000.0f),
+             10, 115, 10, YELLOW);
+}
+
+// Runs on capture workers, so it stays clear of ExportImage and TextFormat: both go through
+// raylib's static text buffers, which the game thread uses at the same time. Frames arrive
+// bottom-up as glReadPixels returns them; ffmpeg flips video, PNGs are flipped here.
+bool WriteCapturedFrame(unsigned char *pixels, int frameIndex) {
+    size_t rowBytes = (size_t)capture.width * 4;
+    size_t frameBytes = rowBytes * capture.height;
+    if (capture.video != NULL) return fwrite(pixels, 1, frameBytes, capture.video) == frameBytes;
+    unsigned char *row = MemAlloc((unsigned int)rowBytes);
+    if (row == NULL) return false;
+    for (int top = 0, bottom = capture.height - 1; top < bottom; top++, bottom--) {
+        memcpy(row, pixels + top * rowBytes, rowBytes);
+        memcpy(pixels + top * rowBytes, pixels + bottom * rowBytes, rowBytes);
+        memcpy(pixels + bottom * rowBytes, row, rowBytes);
+    }
+    MemFree(row);
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/frame_%06d.png", capture.directory, frameIndex);
+    Image image = {pixels, capture.width, capture.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+    int size = 0;
+    unsigned char *png = ExportImageToMemory(image, ".png", &size);
+    FILE *file = png != NULL ? fopen(path, "wb") : NULL;
+    bool written = file != NULL && fwrite(png, 1, size, file) == (size_t)size;
+    if (file != NULL && fclose(file) != 0) written = false;
+    MemFree(png);
+    return written;
+}
+
+// Workers take frames off the ring, encode and write them, and hand the buffer back to the
+// pool. Video goes through a single worker so frames reach the encoder in order.
+void *CaptureWorkerMain(void *argument) {
+    (void)argument;
+    while (true) {
+        pthread_mutex_lock(&capture.lock);
+        while (capture.count == 0 && capture.running) pthread_cond_wait(&capture.ready, &capture.lock);
+        if (capture.count == 0) {
+            pthread_mutex_unlock(&capture.lock);
+            return NULL;
         }
+        unsigned char *pixels = capture.pixels[capture.head];
+        int frameIndex = capture.frameIndices[capture.head];
+        capture.head = (capture.head + 1) % CAPTURE_RING_SIZE;
+        capture.count--;
+        pthread_mutex_unlock(&capture.lock);
+
+        if (!atomic_load(&capture.failed) && !WriteCapturedFrame(pixels, frameIndex)) atomic_store(&capture.failed, true);
+        pthread_mutex_lock(&capture.lock);
+        capture.buffers[capture.freeCount++] = pixels;
+        pthread_cond_signal(&capture.space);
+        pthread_mutex_unlock(&capture.lock);
     }
-    if (allBlocksGone) game_state = GAME_WON;
 }
+
+// Takes a buffer from the pool. When every buffer is still with the workers the frame is
+// dropped, unless capture is lossless (offline rendering), in which case the game waits.
+unsigned char *AcquireCaptureBuffer(void) {
+    pthread_mutex_lock(&capture.lock);
+    while (capture.lossless && capture.freeCount == 0) pthread_cond_wait(&capture.space, &capture.lock);
+    unsigned char *buffer = capture.freeCount > 0 ? capture.buffers[--capture.freeCount] : NULL;
+    pthread_mutex_unlock(&capture.lock);
+    if (buffer == NULL) capture.droppedFrames++;
+    return buffer;
+}
+
+void QueueCapturedFrame(unsigned char *buffer) {
+    pthread_mutex_lock(&capture.lock);
+    int slot = (capture.head + capture.count) % CAPTURE_RING_SIZE;
+    capture.pixels[slot] = buffer;
+    capture.frameIndices[slot] = capture.capturedFrames++;
+    capture.count++;
+    pthread_cond_signal(&capture.ready);
+    pthread_mutex_unlock(&capture.lock);
+}
+
+// Moves finished pixel-pack readbacks into pool buffers for the workers, oldest first. With
+// wait set it blocks on the oldest readback, otherwise it stops at the first one the GPU has
+// not finished, so the game thread never stalls on the copy.
+void CollectReadbacks(bool wait) {
+    size_t frameBytes = (size_t)capture.width * capture.height * 4;
+    while (capture.readbackCount > 0) {
+        int slot = capture.readbackHead;
+        GLenum status = glClientWaitSync(capture.fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 1000000000 : 0);
+        if (status == GL_TIMEOUT_EXPIRED) return;
+        wait = false;
+        glDeleteSync(capture.fences[slot]);
+        capture.readbackHead = (slot + 1) % CAPTURE_READBACKS;
+        capture.readbackCount--;
+        if (status == GL_WAIT_FAILED) {
+            atomic_store(&capture.failed, true);
+            continue;
+        }
+        unsigned char *buffer = AcquireCaptureBuffer();
+        if (buffer == NULL) continue;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.readbacks[slot]);
+        const void *pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)frameBytes, GL_MAP_READ_BIT);
+        if (pixels != NULL) {
+            memcpy(buffer, pixels, frameBytes);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (pixels != NULL) {
+            QueueCapturedFrame(buffer);
+            continue;
+        }
+        atomic_store(&capture.failed, true);
+        pthread_mutex_lock(&capture.lock);
+        capture.buffers[capture.freeCount++] = buffer;
+        pthread_mutex_unlock(&capture.lock);
+    }
+}
+
+bool StartCapture(const char *directory, const char *videoPath, bool lossless) {
+    capture.width = GetRenderWidth();
+    capture.height = GetRenderHeight();
+    capture.directory = directory;
+    capture.lossless = lossless;
+    size_t frameBytes = (size_t)capture.width * capture.height * 4;
+    int workerCount = CAPTURE_WORKERS;
+    if (videoPath != NULL) {
+        // popen succeeds as long as the shell starts, so check for the encoder up front, and
+        // ignore SIGPIPE so an encoder that exits early fails the write instead of the game.
+        if (system("ffmpeg -version > /dev/null 2>&1") != 0) return false;
+        signal(SIGPIPE, SIG_IGN);
+        const char *command = TextFormat("ffmpeg -loglevel error -y -f rawvideo -pix_fmt rgba -s %dx%d -r 60 -i - "
+                                         "-vf vflip -c:v libx264 -pix_fmt yuv420p \"%s\"", capture.width, capture.height, videoPath);
+        capture.video = popen(command, "w");
+        if (capture.video == NULL) return false;
+        workerCount = 1;
+    }
+    for (int i = 0; i < CAPTURE_RING_SIZE; i++) {
+        capture.buffers[i] = MemAlloc((unsigned int)frameBytes);
+        if (capture.buffers[i] == NULL) break;
+        capture.freeCount++;
+    }
+    pthread_mutex_init(&capture.lock, NULL);
+    pthread_cond_init(&capture.ready, NULL);
+    pthread_cond_init(&capture.space, NULL);
+    capture.running = capture.freeCount == CAPTURE_RING_SIZE;
+    for (int i = 0; i < workerCount && capture.running; i++) {
+        if (pthread_create(&capture.workers[i], NULL, CaptureWorkerMain, NULL) != 0) break;
+        capture.workerCount++;
+    }
+    capture.enabled = capture.workerCount > 0;
+    if (!capture.enabled) {
+        for (int i = 0; i < capture.freeCount; i++) MemFree(capture.buffers[i]);
+        if (capture.video != NULL) pclose(capture.video);
+        return false;
+    }
+
+    // Fences need GL 3.2, so older contexts read straight into the pool buffer instead.
+    int version = rlGetVersion();
+    capture.asyncReadback = version == RL_OPENGL_33 || version == RL_OPENGL_43;
+    if (capture.asyncReadback) {
+        glGenBuffers(CAPTURE_READBACKS, capture.readbacks);
+        for (int i = 0; i < CAPTURE_READBACKS; i++) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.readbacks[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)frameBytes, NULL, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    return true;
+}
+
+// Call after the frame is drawn and before EndDrawing swaps it away. On GL 3.3 the readback
+// goes into a pixel-pack buffer and is collected a few frames later, once its fence signals.
+void CaptureFrame(void) {
+    if (!capture.enabled || atomic_load(&capture.failed)) return;
+    rlDrawRenderBatchActive();
+    if (!capture.asyncReadback) {
+        unsigned char *buffer = AcquireCaptureBuffer();
+        if (buffer == NULL) return;
+        glReadPixels(0, 0, capture.width, capture.height, GL_RGBA, GL_UNSIGNED_BYTE, buffer);
+        QueueCapturedFrame(buffer);
+        return;
+    }
+
+    CollectReadbacks(capture.lossless && capture.readbackCount == CAPTURE_READBACKS);
+    if (capture.readbackCount == CAPTURE_READBACKS) {
+        capture.droppedFrames++;
+        return;
+    }
+    int slot = (capture.readbackHead + capture.readbackCount) % CAPTURE_READBACKS;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.readbacks[slot]);
+    glReadPixels(0, 0, capture.width, capture.height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    capture.fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    capture.readbackCount++;
+}
+
+// Must run before CloseWindow: the outstanding readbacks still need the GL context.
+void StopCapture(void) {
+    if (!capture.enabled) return;
+    if (capture.asyncReadback) {
+        bool lossless = capture.lossless;
+        capture.lossless = true;
+        while (capture.readbackCount > 0) CollectReadbacks(true);
+        capture.lossless = lossless;
+        glDeleteBuffers(CAPTURE_READBACKS, capture.readbacks);
+    }
+    pthread_mutex_lock(&capture.lock);
+    capture.running = false;
+    pthread_cond_broadcast(&capture.ready);
+    pthread_mutex_unlock(&capture.lock);
+    for (int i = 0; i < capture.workerCount; i++) pthread_join(capture.workers[i], NULL);
+    for (int i = 0; i < capture.freeCount; i++) MemFree(capture.buffers[i]);
+    if (capture.video != NULL && pclose(capture.video) != 0) atomic_store(&capture.failed, true);
+    if (atomic_load(&capture.failed)) TraceLog(LOG_WARNING, "CAPTURE: writing frames failed, output is incomplete");
+    TraceLog(LOG_INFO, "CAPTURE: %d frames captured, %d dropped", capture.capturedFrames, capture.droppedFrames);
+    capture.enabled = false;
+}
+void DestroyBlock(BlockSet *blocks, int slot, Ball *ball, PowerUpSet *powerUps) {
+    Vector2 position = blocks->positions[slot];
+    int last = --blocks->count;
+    PushTelemetry(TELEMETRY_BLOCK_DESTROYED, blocks->cells[slot]);
+    blocks->slots[blocks->cells[slot]] = -1;
+    blocks->positions[slot] = blocks->positions[last];
+    blocks->types[slot] = blocks->types[last];
+    blocks->cells[slot] = blocks->cells[last];
+    if (slot != last) blocks->slots[blocks->cells[slot]] = slot;
+    blockGridVersion++;
+    PlaySoundEffect(SOUND_BLOCK_BREAK, 0.6f);
+    if (ball->effectStacks[EFFECT_MULTI_HIT] == 0) ball->velocity.y = -ball->velocity.y;
+    DropPowerUp(position, powerUps);
+    if (blocks->count == 0) game_state = GAME_WON;
+}
+// Only flips velocity heading into a wall, so a ball still overlapping it after a bounce is not flipped back.
 void HandleBallWallCollision(Ball *ball) {
-    if (ball->base.position.x - ball->radius < 0 || ball->base.position.x + ball->radius > WINDOW_WIDTH) {
-        ball->base.velocity.x = -ball->base.velocity.x;
+    if ((ball->position.x - ball->radius < 0 && ball->velocity.x < 0) ||
+        (ball->position.x + ball->radius > WINDOW_WIDTH && ball->velocity.x > 0)) {
+        ball->velocity.x = -ball->velocity.x;
     }
-    if (ball->base.position.y - ball->radius < 0) {
-        ball->base.velocity.y = -ball->base.velocity.y;
+    if (ball->position.y - ball->radius < 0 && ball->velocity.y < 0) {
+        ball->velocity.y = -ball->velocity.y;
     }
 }
 
 void HandleBallPlayerCollision(Ball *ball, Player *player) {
-    Rectangle playerRect = {player->base.position.x, player->base.position.y, player->width, player->height};
-    Rectangle ballRect = {ball->base.position.x - ball->radius, ball->base.position.y - ball->radius, ball->radius * 2, ball->radius * 2};
+    Rectangle playerRect = {player->position.x, player->position.y, player->width, player->height};
+    Rectangle ballRect = {ball->position.x - ball->radius, ball->position.y - ball->radius, ball->radius * 2, ball->radius * 2};
 
     if (CheckCollisionRecs(playerRect, ballRect)) {
-        Vector2 collisionPoint = Vector2Subtract(ball->base.position, player->base.position);
+        if (player->effectStacks[EFFECT_STICKY_PADDLE] > 0 && ball->velocity.y > 0) {
+            ball->isActive = false;
+            PlaySoundEffect(SOUND_PADDLE_HIT, 0.4f);
+            return;
+        }
+        Vector2 collisionPoint = Vector2Subtract(ball->position, player->position);
         collisionPoint = Vector2Normalize(collisionPoint);
 
-        if (ball->base.position.x < player->base.position.x) {
-            ball->base.velocity.x = -ball->base.velocity.x;
+        if (ball->position.x < player->position.x) {
+            ball->velocity.x = -ball->velocity.x;
         }
 
-        if (ball->base.position.y < player->base.position.y) {
-            ball->base.velocity.y = -ball->base.velocity.y;
-        } else if (ball->base.position.y > player->base.position.y + player->height) {
-            ball->base.velocity.y = -ball->base.velocity.y;
+        if (ball->position.y < player->position.y) {
+            ball->velocity.y = -ball->velocity.y;
+        } else if (ball->position.y > player->position.y + player->height) {
+            ball->velocity.y = -ball->velocity.y;
         }
 
-        ball->base.velocity = Vector2Scale(Vector2Normalize(ball->base.velocity), ball->speed);
+        ball->velocity = Vector2Scale(Vector2Normalize(ball->velocity), ball->speed);
         ball->speed *= 1.03f;
+        PushTelemetry(TELEMETRY_BALL_SPEED, ball->speed);
+        PlaySoundEffect(SOUND_PADDLE_HIT, 0.8f);
     }
 }
 
-void HandleBallBlockCollision(Ball *ball, Block *blocks, int rowCount, int columnCount, PowerUp *powerUps) {
-    int columnIndex = (ball->base.position.x) / BLOCK_SIZE;
-    int rowIndex = (ball->base.position.y) / TILE_HEIGHT;
-    if (rowIndex >= 0 && rowIndex < rowCount && columnIndex >= 0 && columnIndex < columnCount) {
-        Block *block = &blocks[rowIndex * columnCount + columnIndex];
-        if (block->base.isActive) {
-            Rectangle blockRect = {block->base.position.x, block->base.position.y, BLOCK_SIZE, TILE_HEIGHT};
-            Rectangle ballRect = {ball->base.position.x - ball->radius, ball->base.position.y - ball->radius, ball->radius * 2, ball->radius * 2};
+// A block is hit once the ball's centre enters its cell. The stepped and the event-driven
+// simulation both use this rule and resolve the hit here.
+void HitBlock(Ball *ball, BlockSet *blocks, int slot, PowerUpSet *powerUps) {
+    Vector2 blockPosition = blocks->positions[slot];
+    DestroyBlock(blocks, slot, ball, powerUps);
 
-            if (CheckCollisionRecs(ballRect, blockRect)) {
-                DestroyBlock(block, ball, powerUps, rowCount, columnCount);
+    Vector2 normal = {0, 0};
 
-                Vector2 normal = {0, 0};
+    if (ball->position.x < blockPosition.x) {
+        normal = (Vector2){1, 0};
+    } else if (ball->position.x > blockPosition.x + BLOCK_SIZE) {
+        normal = (Vector2){-1, 0};
+    }
 
-                if (ball->base.position.x < block->base.position.x) {
-                    normal = (Vector2){1, 0};
-                } else if (ball->base.position.x > block->base.position.x + BLOCK_SIZE) {
-                    normal = (Vector2){-1, 0};
-                }
+    if (ball->position.y < blockPosition.y) {
+        normal = (Vector2){0, 1};
+    } else if (ball->position.y > blockPosition.y + TILE_HEIGHT) {
+        normal = (Vector2){0, -1};
+    }
 
-                if (ball->base.position.y < block->base.position.y) {
-                    normal = (Vector2){0, 1};
-                } else if (ball->base.position.y > block->base.position.y + TILE_HEIGHT) {
-                    normal = (Vector2){0, -1};
-                }
+    if (ball->effectStacks[EFFECT_MULTI_HIT] == 0) {
+        ball->velocity = Vector2Reflect(ball->velocity, normal);
+        ball->velocity = Vector2Scale(Vector2Normalize(ball->velocity), ball->speed);
+    }
+}
 
-                ball->base.velocity = Vector2Reflect(ball->base.velocity, normal);
-                ball->base.velocity = Vector2Scale(Vector2Normalize(ball->base.velocity), ball->speed);
-            }
+void HandleBallBlockCollision(Ball *ball, BlockSet *blocks, int rowCount, int columnCount, PowerUpSet *powerUps) {
+    int columnIndex = (ball->position.x) / BLOCK_SIZE;
+    int rowIndex = (ball->position.y) / TILE_HEIGHT;
+    if (rowIndex >= 0 && rowIndex < rowCount && columnIndex >= 0 && columnIndex < columnCount) {
+        int slot = blocks->slots[rowIndex * columnCount + columnIndex];
+        if (slot >= 0) {
+            Vector2 blockPosition = blocks->positions[slot];
+            Rectangle blockRect = {blockPosition.x, blockPosition.y, BLOCK_SIZE, TILE_HEIGHT};
+            Rectangle ballRect = {ball->position.x - ball->radius, ball->position.y - ball->radius, ball->radius * 2, ball->radius * 2};
+            if (CheckCollisionRecs(ballRect, blockRect)) HitBlock(ball, blocks, slot, powerUps);
         }
     }
 }
-void HandlePowerUpCollision(PowerUp *powerUp, Player *player) {
-    Rectangle playerRect = {player->base.position.x, player->base.position.y, player->width, player->height};
-    Rectangle powerUpRect = {powerUp->base.position.x, powerUp->base.position.y, 20, 20};
-    if (powerUp->base.isActive && CheckCollisionRecs(playerRect, powerUpRect)) {
-        powerUp->base.isActive = false;
-        if (powerUp->type == 0) powerUpEffects[0](player);
-        else if (powerUp->type == 1) powerUpEffects[1](player);
-    }
+bool HandlePowerUpCollision(PowerUpSet *powerUps, int slot, Player *player, Ball *ball) {
+    Rectangle playerRect = {player->position.x, player->position.y, player->width, player->height};
+    Rectangle powerUpRect = {powerUps->positions[slot].x, powerUps->positions[slot].y, 20, 20};
+    if (!CheckCollisionRecs(playerRect, powerUpRect)) return false;
+    int type = powerUps->types[slot];
+    RemovePowerUp(powerUps, slot);
+    PushTelemetry(TELEMETRY_POWERUP_PICKED_UP, type);
+    powerUpEffects[type](player, ball);
+    return true;
 }
 bool HandleBallLossCondition(Ball *ball, Player *player) {
-    if (ball->base.position.y + ball->radius > WINDOW_HEIGHT) {
-        ball->base.isActive = false;
+    if (ball->position.y + ball->radius > WINDOW_HEIGHT) {
+        ball->isActive = false;
         player->lives--;
+        PushTelemetry(TELEMETRY_LIFE_LOST, player->lives);
         if (player->lives <= 0) game_state = GAME_OVER;
         return true;
     }
     return false;
 }
 
-bool HandleBallCollisions(Ball *ball, Player *player, Block *blocks, int rowCount, int columnCount, PowerUp *powerUps) {
+bool HandleBallCollisions(Ball *ball, Player *player, BlockSet *blocks, int rowCount, int columnCount, PowerUpSet *powerUps) {
     HandleBallWallCollision(ball);
     HandleBallPlayerCollision(ball, player);
     HandleBallBlockCollision(ball, blocks, rowCount, columnCount, powerUps);
     return HandleBallLossCondition(ball, player);
 }
 
+void PushInputEvent(InputQueue *input, InputEvent event) {
+    if (input->count == MAX_INPUT_EVENTS) return;
+    input->events[(input->head + input->count) % MAX_INPUT_EVENTS] = event;
+    input->count++;
+}
+
+void ClearInputEvents(InputQueue *input) {
+    input->head = 0;
+    input->count = 0;
+}
+
+// raylib only reports input when it polls, so an event is known to have happened somewhere in the
+// tick's interval; it is applied at the middle of that interval, and latency is measured from the poll.
+void SampleInput(InputQueue *input, double tickStart, float deltaTime) {
+    double time = tickStart + deltaTime * 0.5;
+    double pollTime = GetTime();
+    float pollWait = deltaTime * 0.5f;
+    float direction = 0.0f;
+    if (IsKeyDown(KEY_A)) direction = -1.0f;
+    else if (IsKeyDown(KEY_D)) direction = 1.0f;
+    if (direction != input->paddleDirection) {
+        PushInputEvent(input, (InputEvent){time, INPUT_PADDLE_DIRECTION, direction, {0, 0}, pollTime, pollWait});
+        input->paddleDirection = direction;
+    }
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        PushInputEvent(input, (InputEvent){time, INPUT_LAUNCH, 0.0f, GetMousePosition(), pollTime, pollWait});
+    }
+}
+
+void LaunchBall(Ball *ball, Vector2 target) {
+    if (ball->isActive) return;
+    Vector2 direction = Vector2Subtract(target, ball->position);
+    ball->velocity = Vector2Scale(Vector2Normalize(direction), ball->speed);
+    ball->isActive = true;
+    PushTelemetry(TELEMETRY_BALL_SPEED, ball->speed);
+}
+
+void ApplyInputEvent(GameStateData *gameData, InputEvent *event) {
+    switch (event->type) {
+        case INPUT_PADDLE_DIRECTION:
+            gameData->player.velocity.x = event->direction * PLAYER_SPEED;
+            break;
+        case INPUT_LAUNCH:
+            LaunchBall(&gameData->ball, event->mousePosition);
+            break;
+    }
+    LatencyStats *latency = &gameData->latency;
+    if (event->pollTime > 0 && (latency->pendingPollTime < 0 || event->pollTime < latency->pendingPollTime)) {
+        latency->pendingPollTime = event->pollTime;
+        latency->pendingWait = event->pollWait;
+    }
+}
+
+void RecordPresentLatency(LatencyStats *latency, double presentTime) {
+    if (latency->pendingPollTime < 0) return;
+    latency->lastLatency = presentTime - latency->pendingPollTime;
+    latency->lastWait = latency->pendingWait;
+    latency->totalLatency += latency->lastLatency;
+    if (latency->lastLatency > latency->maxLatency) latency->maxLatency = latency->lastLatency;
+    latency->samples++;
+    latency->pendingPollTime = -1.0;
+}
+
+void DrawLatencyOverlay(LatencyStats *latency) {
+    double average = latency->samples > 0 ? latency->totalLatency / latency->samples : 0.0;
+    DrawText(TextFormat("poll->present  last %.1f ms  avg %.1f ms  max %.1f ms  (+ est. %.1f ms input->poll)",
+                        latency->lastLatency * 1000.0, average * 1000.0, latency->maxLatency * 1000.0, latency->lastWait * 1000.0),
+             10, 100, 10, YELLOW);
+}
+
 void UpdatePlayer(Player *player, float deltaTime) {
-    if (IsKeyDown(KEY_A)) player->base.velocity.x = -PLAYER_SPEED;
-    else if (IsKeyDown(KEY_D)) player->base.velocity.x = PLAYER_SPEED;
-    else player->base.velocity.x = 0;
-    player->base.position = Vector2Add(player->base.position, Vector2Scale(player->base.velocity, deltaTime));
-    if (player->base.position.x < 0) player->base.position.x = 0;
-    if (player->base.position.x + player->width > WINDOW_WIDTH) player->base.position.x = WINDOW_WIDTH - player->width;
-}
-
-void UpdateBall(Ball *ball, Player *player, Block *blocks, int rowCount, int columnCount, PowerUp *powerUps, float deltaTime) {
-    if (!ball->base.isActive) {
-        ball->speed = BALL_SPEED;
-        ball->base.position.x = player->base.position.x + player->width / 2;
-        ball->base.position.y = player->base.position.y - ball->radius - 5;
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            Vector2 direction = Vector2Subtract(GetMousePosition(), ball->base.position);
-            ball->base.velocity = Vector2Scale(Vector2Normalize(direction), ball->speed);
-            ball->base.isActive = true;
-        }
+    player->position = Vector2Add(player->position, Vector2Scale(player->velocity, deltaTime));
+    if (player->position.x < 0) player->position.x = 0;
+    if (player->position.x + player->width > WINDOW_WIDTH) player->position.x = WINDOW_WIDTH - player->width;
+}
+
+void AttachBallToPlayer(Ball *ball, Player *player) {
+    ball->speed = BALL_SPEED * GetBallSpeedScale(ball);
+    ball->position.x = player->position.x + player->width / 2;
+    ball->position.y = player->position.y - ball->radius - 5;
+}
+
+void UpdateBall(Ball *ball, Player *player, BlockSet *blocks, int rowCount, int columnCount, PowerUpSet *powerUps, float deltaTime) {
+    if (!ball->isActive) {
+        AttachBallToPlayer(ball, player);
     } else {
-        ball->base.position = Vector2Add(ball->base.position, Vector2Scale(ball->base.velocity, deltaTime));
+        ball->position = Vector2Add(ball->position, Vector2Scale(ball->velocity, deltaTime));
         HandleBallCollisions(ball, player, blocks, rowCount, columnCount, powerUps);
     }
 }
 
+// The tick covers [tickStart, tickStart + deltaTime], the interval that just elapsed and in which the
+// polled input happened; queued input is applied at the first sub-step that ends after its timestamp.
+void SimulateTick(GameStateData *gameData, double tickStart, float deltaTime) {
+    InputQueue *input = &gameData->input;
+    int steps = (int)(deltaTime / SIM_SUBSTEP) + 1;
+    float stepTime = deltaTime / steps;
+    for (int step = 0; step < steps && game_state == GAME_PLAYING; step++) {
+        double stepEnd = tickStart + (step + 1) * (double)stepTime;
+        gameClock = stepEnd;
+        AdvanceTimers(&effectTimers, stepEnd);
+        while (input->count > 0 && input->events[input->head].time < stepEnd) {
+            ApplyInputEvent(gameData, &input->events[input->head]);
+            input->head = (input->head + 1) % MAX_INPUT_EVENTS;
+            input->count--;
+        }
+        UpdatePlayer(&gameData->player, stepTime);
+        UpdateBall(&gameData->ball, &gameData->player, &gameData->blocks, gameData->rowCount, gameData->columnCount, &gameData->powerUps, stepTime);
+    }
+}
+
+// The paddle/ball sub-steps run first because block hits spawn power-ups. Removal and pickups
+// compact the packed arrays, so they walk backwards and a swapped-in entry is one already seen.
+void StepGame(GameStateData *gameData, double tickStart, float deltaTime) {
+    SimulateTick(gameData, tickStart, deltaTime);
+    MovePowerUps(&gameData->powerUps, deltaTime);
+    RemoveMissedPowerUps(&gameData->powerUps);
+    for (int i = gameData->powerUps.count - 1; i >= 0; i--) {
+        HandlePowerUpCollision(&gameData->powerUps, i, &gameData->player, &gameData->ball);
+    }
+}
+
+// Earliest time within the horizon at which a moving rectangle starts to overlap a static one,
+// or -1 if it never does. Pairs that already overlap are ignored so a resolved contact is not re-reported.
+float SweptRectTime(Rectangle moving, Vector2 velocity, Rectangle target, float horizon) {
+    float entry = 0.0f;
+    float exit = horizon;
+    float movingMin[2] = {moving.x, moving.y};
+    float movingMax[2] = {moving.x + moving.width, moving.y + moving.height};
+    float targetMin[2] = {target.x, target.y};
+    float targetMax[2] = {target.x + target.width, target.y + target.height};
+    float axisVelocity[2] = {velocity.x, velocity.y};
+    bool overlapping = true;
+    for (int axis = 0; axis < 2; axis++) {
+        float axisEntry;
+        float axisExit;
+        if (axisVelocity[axis] == 0.0f) {
+            if (movingMax[axis] <= targetMin[axis] || movingMin[axis] >= targetMax[axis]) return -1.0f;
+            continue;
+        } else if (axisVelocity[axis] > 0.0f) {
+            axisEntry = (targetMin[axis] - movingMax[axis]) / axisVelocity[axis];
+            axisExit = (targetMax[axis] - movingMin[axis]) / axisVelocity[axis];
+        } else {
+            axisEntry = (targetMax[axis] - movingMin[axis]) / axisVelocity[axis];
+            axisExit = (targetMin[axis] - movingMax[axis]) / axisVelocity[axis];
+        }
+        if (axisEntry >= 0.0f) overlapping = false;
+        if (axisEntry > entry) entry = axisEntry;
+        if (axisExit < exit) exit = axisExit;
+    }
+    if (overlapping || entry > exit || entry > horizon) return -1.0f;
+    return entry;
+}
+
+float GetPlayerMotion(Player *player) {
+    float velocityX = player->velocity.x;
+    if (velocityX < 0 && player->position.x <= 0) return 0.0f;
+    if (velocityX > 0 && player->position.x + player->width >= WINDOW_WIDTH) return 0.0f;
+    return velocityX;
+}
+
+void ConsiderImpact(Impact *next, float time, ImpactType type, int index) {
+    if (time < 0.0f) return;
+    if (next->type == IMPACT_NONE || time < next->time) {
+        *next = (Impact){time, type, index};
+    }
+}
+
+Impact FindNextImpact(GameStateData *gameData, double simTime, float horizon) {
+    Impact next = {horizon, IMPACT_NONE, -1};
+    Ball *ball = &gameData->ball;
+    Player *player = &gameData->player;
+    float playerMotion = GetPlayerMotion(player);
+    Rectangle playerRect = {player->position.x, player->position.y, player->width, player->height};
+
+    if (playerMotion < 0) ConsiderImpact(&next, player->position.x / -playerMotion, IMPACT_PLAYER_WALL, -1);
+    if (playerMotion > 0) ConsiderImpact(&next, (WINDOW_WIDTH - player->width - player->position.x) / playerMotion, IMPACT_PLAYER_WALL, -1);
+
+    if (gameData->autoplay.enabled && playerMotion != 0) {
+        float remaining = gameData->autoplay.targetX - (player->position.x + player->width / 2);
+        if (remaining * playerMotion > 0) ConsiderImpact(&next, remaining / playerMotion, IMPACT_AUTOPLAY_TARGET, -1);
+    }
+
+    double expiry = GetNextTimerExpiry(&effectTimers);
+    if (expiry >= 0) ConsiderImpact(&next, fmaxf((float)(expiry - simTime), 0.0f), IMPACT_EFFECT_EXPIRY, -1);
+
+    if (gameData->input.count > 0) {
+        InputEvent *event = &gameData->input.events[gameData->input.head];
+        ConsiderImpact(&next, fmaxf((float)(event->time - simTime), 0.0f), IMPACT_INPUT, -1);
+    }
+
+    if (ball->isActive) {
+        Vector2 position = ball->position;
+        Vector2 velocity = ball->velocity;
+        if (velocity.x < 0) ConsiderImpact(&next, fmaxf((ball->radius - position.x) / velocity.x, 0.0f), IMPACT_WALL, -1);
+        if (velocity.x > 0) ConsiderImpact(&next, fmaxf((WINDOW_WIDTH - ball->radius - position.x) / velocity.x, 0.0f), IMPACT_WALL, -1);
+        if (velocity.y < 0) ConsiderImpact(&next, fmaxf((ball->radius - position.y) / velocity.y, 0.0f), IMPACT_WALL, -1);
+        if (velocity.y > 0) ConsiderImpact(&next, fmaxf((WINDOW_HEIGHT - ball->radius - position.y) / velocity.y, 0.0f), IMPACT_LOSS, -1);
+
+        Rectangle ballRect = {position.x - ball->radius, position.y - ball->radius, ball->radius * 2, ball->radius * 2};
+        Vector2 relativeVelocity = {velocity.x - playerMotion, velocity.y};
+        ConsiderImpact(&next, SweptRectTime(ballRect, relativeVelocity, playerRect, next.time), IMPACT_PLAYER, -1);
+
+        Rectangle centerRect = {position.x, position.y, 0, 0};
+        BlockSet *blocks = &gameData->blocks;
+        for (int i = 0; i < blocks->count; i++) {
+            Rectangle blockRect = {blocks->positions[i].x, blocks->positions[i].y, BLOCK_SIZE, TILE_HEIGHT};
+            ConsiderImpact(&next, SweptRectTime(centerRect, velocity, blockRect, next.time), IMPACT_BLOCK, i);
+        }
+    }
+
+    PowerUpSet *powerUps = &gameData->powerUps;
+    for (int i = 0; i < powerUps->count; i++) {
+        Vector2 position = powerUps->positions[i];
+        Vector2 velocity = powerUps->velocities[i];
+        Rectangle powerUpRect = {position.x, position.y, 20, 20};
+        Vector2 relativeVelocity = {-playerMotion, velocity.y};
+        ConsiderImpact(&next, SweptRectTime(powerUpRect, relativeVelocity, playerRect, next.time), IMPACT_POWERUP_PICKUP, i);
+        ConsiderImpact(&next, (WINDOW_HEIGHT - position.y) / velocity.y, IMPACT_POWERUP_MISSED, i);
+    }
+    return next;
+}
+
+// Everything moves in straight lines between impacts, so the world can be advanced in one step.
+void AdvanceWorld(GameStateData *gameData, float deltaTime) {
+    UpdatePlayer(&gameData->player, deltaTime);
+    Ball *ball = &gameData->ball;
+    if (ball->isActive) {
+        ball->position = Vector2Add(ball->position, Vector2Scale(ball->velocity, deltaTime));
+    } else {
+        AttachBallToPlayer(ball, &gameData->player);
+    }
+    MovePowerUps(&gameData->powerUps, deltaTime);
+}
+
+void ResolveImpact(GameStateData *gameData, Impact impact) {
+    Ball *ball = &gameData->ball;
+    switch (impact.type) {
+        case IMPACT_WALL:
+            HandleBallWallCollision(ball);
+            break;
+        case IMPACT_PLAYER:
+            HandleBallPlayerCollision(ball, &gameData->player);
+            break;
+        case IMPACT_BLOCK:
+            HitBlock(ball, &gameData->blocks, impact.index, &gameData->powerUps);
+            break;
+        case IMPACT_LOSS:
+            HandleBallLossCondition(ball, &gameData->player);
+            AttachBallToPlayer(ball, &gameData->player);
+            break;
+        case IMPACT_POWERUP_PICKUP:
+            HandlePowerUpCollision(&gameData->powerUps, impact.index, &gameData->player, &gameData->ball);
+            break;
+        case IMPACT_INPUT:
+            ApplyInputEvent(gameData, &gameData->input.events[gameData->input.head]);
+            gameData->input.head = (gameData->input.head + 1) % MAX_INPUT_EVENTS;
+            gameData->input.count--;
+            break;
+        case IMPACT_AUTOPLAY_TARGET:
+            gameData->player.velocity.x = 0.0f;
+            gameData->input.paddleDirection = 0.0f;
+            break;
+        default:
+            break;
+    }
+}
+
+// Advances straight to the next impact (or the horizon) and resolves it; returns the simulated time consumed.
+// Missed power-ups are dropped only after the impact is resolved, since impact indices are packed slots.
+float AdvanceToNextImpact(GameStateData *gameData, double simTime, float horizon) {
+    Impact impact = FindNextImpact(gameData, simTime, horizon);
+    if (impact.type == IMPACT_NONE) {
+        AdvanceWorld(gameData, horizon);
+        RemoveMissedPowerUps(&gameData->powerUps);
+        return horizon;
+    }
+    float elapsed = fminf(impact.time + IMPACT_EPSILON, horizon);
+    AdvanceWorld(gameData, elapsed);
+    gameClock = simTime + elapsed;
+    AdvanceTimers(&effectTimers, gameClock);
+    ResolveImpact(gameData, impact);
+    RemoveMissedPowerUps(&gameData->powerUps);
+    return elapsed;
+}
+
+// Casts the ball's path through wall reflections and live blocks until it comes back down to the
+// paddle line. The result is kept while the velocity and the block grid are unchanged and the ball
+// has only moved along its first segment.
+Trajectory *PredictTrajectory(Trajectory *trajectory, GameStateData *gameData, Ball *ball, Vector2 velocity) {
+    Vector2 origin = ball->position;
+    bool passesBlocks = ball->effectStacks[EFFECT_MULTI_HIT] > 0;
+    if (trajectory->valid && trajectory->gridVersion == blockGridVersion && trajectory->passesBlocks == passesBlocks &&
+        trajectory->velocity.x == velocity.x && trajectory->velocity.y == velocity.y) {
+        Vector2 moved = Vector2Subtract(origin, trajectory->origin);
+        if (fabsf(moved.x * velocity.y - moved.y * velocity.x) <= 0.5f * Vector2Length(velocity)) return trajectory;
+    }
+
+    trajectory->origin = origin;
+    trajectory->velocity = velocity;
+    trajectory->gridVersion = blockGridVersion;
+    trajectory->passesBlocks = passesBlocks;
+    trajectory->valid = true;
+    trajectory->lands = false;
+    trajectory->points[0] = origin;
+    trajectory->pointCount = 1;
+
+    float landingY = gameData->player.position.y - ball->radius;
+    uint64_t consumedBlocks = 0;
+    Vector2 position = origin;
+    for (int bounce = 0; bounce <= MAX_TRAJECTORY_BOUNCES; bounce++) {
+        if (velocity.x == 0.0f && velocity.y == 0.0f) break;
+        Impact next = {0.0f, IMPACT_NONE, -1};
+        if (velocity.x < 0) ConsiderImpact(&next, fmaxf((ball->radius - position.x) / velocity.x, 0.0f), IMPACT_WALL, 0);
+        if (velocity.x > 0) ConsiderImpact(&next, fmaxf((WINDOW_WIDTH - ball->radius - position.x) / velocity.x, 0.0f), IMPACT_WALL, 0);
+        if (velocity.y < 0) ConsiderImpact(&next, fmaxf((ball->radius - position.y) / velocity.y, 0.0f), IMPACT_WALL, 1);
+        if (velocity.y > 0) ConsiderImpact(&next, fmaxf((landingY - position.y) / velocity.y, 0.0f), IMPACT_LOSS, -1);
+
+        Rectangle centerRect = {position.x, position.y, 0, 0};
+        BlockSet *blocks = &gameData->blocks;
+        for (int i = 0; i < blocks->count && !passesBlocks; i++) {
+            if (consumedBlocks & ((uint64_t)1 << i)) continue;
+            Rectangle blockRect = {blocks->positions[i].x, blocks->positions[i].y, BLOCK_SIZE, TILE_HEIGHT};
+            ConsiderImpact(&next, SweptRectTime(centerRect, velocity, blockRect, next.time), IMPACT_BLOCK, i);
+        }
+
+        position = Vector2Add(position, Vector2Scale(velocity, next.time));
+        trajectory->points[trajectory->pointCount++] = position;
+        if (next.type == IMPACT_LOSS) {
+            trajectory->lands = true;
+            trajectory->landingX = position.x;
+            break;
+        } else if (next.type == IMPACT_WALL) {
+            if (next.index == 0) velocity.x = -velocity.x;
+            else velocity.y = -velocity.y;
+        } else if (next.type == IMPACT_BLOCK) {
+            consumedBlocks |= (uint64_t)1 << next.index;
+            velocity.y = -velocity.y;
+        }
+    }
+    return trajectory;
+}
+
+void UpdateAimTrajectory(GameStateData *gameData) {
+    Ball *ball = &gameData->ball;
+    if (ball->isActive) return;
+    Vector2 direction = Vector2Normalize(Vector2Subtract(GetMousePosition(), ball->position));
+    PredictTrajectory(&gameData->trajectory, gameData, ball, Vector2Scale(direction, ball->speed));
+}
+
+// Steers the paddle under the predicted landing point through the input queue, so it is
+// applied at sub-step (or impact) granularity like player input.
+void UpdateAutoplay(GameStateData *gameData, double time) {
+    Ball *ball = &gameData->ball;
+    Player *player = &gameData->player;
+    InputQueue *input = &gameData->input;
+    if (!ball->isActive) {
+        if (input->count == 0) {
+            Vector2 target = {(float)GetRandomValue(0, WINDOW_WIDTH), 0.0f};
+            PushInputEvent(input, (InputEvent){time + AUTOPLAY_LAUNCH_DELAY, INPUT_LAUNCH, 0.0f, target, 0.0, 0.0f});
+        }
+        return;
+    }
+
+    Trajectory *trajectory = PredictTrajectory(&gameData->trajectory, gameData, ball, ball->velocity);
+    gameData->autoplay.targetX = trajectory->lands ? trajectory->landingX : ball->position.x;
+    float remaining = gameData->autoplay.targetX - (player->position.x + player->width / 2);
+    float direction = 0.0f;
+    if (remaining > AUTOPLAY_DEADZONE) direction = 1.0f;
+    else if (remaining < -AUTOPLAY_DEADZONE) direction = -1.0f;
+    if (direction != input->paddleDirection) {
+        PushInputEvent(input, (InputEvent){time, INPUT_PADDLE_DIRECTION, direction, {0, 0}, 0.0, 0.0f});
+        input->paddleDirection = direction;
+    }
+}
+
 void RestartGame(GameStateData *gameData) {
     gameData->rowCount = 3;
     gameData->columnCount = WINDOW_WIDTH / BLOCK_SIZE;
 
     gameData->player = InitPlayer((Vector2){WINDOW_WIDTH / 2 - TILE_WIDTH * 2.5f, WINDOW_HEIGHT - TILE_HEIGHT * 2});
-    gameData->ball = InitBall((Vector2){gameData->player.base.position.x + gameData->player.width / 2, gameData->player.base.position.y - 20});
+    gameData->ball = InitBall((Vector2){gameData->player.position.x + gameData->player.width / 2, gameData->player.position.y - 20});
 
-    for (int rowIndex = 0; rowIndex < gameData->rowCount; rowIndex++) {
-        for (int columnIndex = 0; columnIndex < gameData->columnCount; columnIndex++) {
-            gameData->blocks[rowIndex * gameData->columnCount + columnIndex] = InitBlock((Vector2){columnIndex * BLOCK_SIZE, rowIndex * TILE_HEIGHT}, rowIndex % 3);
-            gameData->blocks[rowIndex * gameData->columnCount + columnIndex].base.isActive = true;
-        }
-    }
+    InitBlocks(&gameData->blocks, gameData->rowCount, gameData->columnCount);
 
     gameData->player.lives = 3;
-    for (int i = 0; i < MAX_POWERUPS; i++) {
-        gameData->powerUps[i].base.isActive = false;
-    }
+    ClearTimers(&effectTimers);
+    gameData->trajectory.valid = false;
+    blockGridVersion++;
+    ClearInputEvents(&gameData->input);
+    gameData->input.paddleDirection = 0.0f;
+    gameData->latency = (LatencyStats){.pendingPollTime = -1.0, .showOverlay = gameData->latency.showOverlay};
+    gameData->powerUps.count = 0;
 }
-void UpdateGameState(GameStateData *gameData, float deltaTime) {
+void UpdateGameState(GameStateData *gameData, double tickStart, float deltaTime) {
     switch (game_state) {
         case GAME_START:
             ClearBackground(BLACK);
             DrawStartScreen();
-            if (IsKeyPressed(KEY_SPACE)) {
+            ClearInputEvents(&gameData->input);
+            if (IsKeyPressed(KEY_SPACE) || gameData->autoplay.enabled) {
                 game_state = GAME_PLAYING;
+                if (gameData->input.paddleDirection != 0.0f) {
+                    PushInputEvent(&gameData->input, (InputEvent){tickStart, INPUT_PADDLE_DIRECTION, gameData->input.paddleDirection, {0, 0}, 0.0, 0.0f});
+                }
             }
             break;
 
         case GAME_PLAYING:
-            UpdatePlayer(&gameData->player, deltaTime);
-            UpdateBall(&gameData->ball, &gameData->player, gameData->blocks, gameData->rowCount, gameData->columnCount, gameData->powerUps, deltaTime);
-            UpdatePowerUps(gameData->powerUps, MAX_POWERUPS, deltaTime);
-            for (int i = 0; i < MAX_POWERUPS; i++) {
-                HandlePowerUpCollision(&gameData->powerUps[i], &gameData->player);
-            }
+            if (gameData->autoplay.enabled) UpdateAutoplay(gameData, tickStart);
+            StepGame(gameData, tickStart, deltaTime);
 
             if (gameData->player.lives <= 0) {
                 game_state = GAME_OVER;
             } else {
-                bool allBlocksDestroyed = true;
-                for (int i = 0; i < gameData->rowCount * gameData->columnCount; i++) {
-                    if (gameData->blocks[i].base.isActive) {
-                        allBlocksDestroyed = false;
-                        break;
-                    }
-                }
-                if (allBlocksDestroyed) {
+                if (gameData->blocks.count == 0) {
                     game_state = GAME_WON;
                 }
+                UpdateAimTrajectory(gameData);
                 if (IsKeyPressed(KEY_F1)) {
                     game_state = GAME_WON;
                 }
@@ -406,14 +1745,14 @@ void UpdateGameState(GameStateData *gameData, float deltaTime) {
 
 
         case GAME_OVER:
-            if (IsKeyPressed(KEY_ENTER)) {
+            if (IsKeyPressed(KEY_ENTER) || gameData->autoplay.enabled) {
                 game_state = GAME_START;
                 RestartGame(gameData);
             }
             break;
 
         case GAME_WON:
-            if (IsKeyPressed(KEY_ENTER)) {
+            if (IsKeyPressed(KEY_ENTER) || gameData->autoplay.enabled) {
                 game_state = GAME_START;
                 RestartGame(gameData);
             }
@@ -424,17 +1763,136 @@ void UpdateGameState(GameStateData *gameData, float deltaTime) {
     }
 }
 
-int main(void) {
+void ScheduleSimulatedLaunch(GameStateData *gameData, double simTime) {
+    Vector2 target = {(float)GetRandomValue(0, WINDOW_WIDTH), 0.0f};
+    PushInputEvent(&gameData->input, (InputEvent){simTime + 0.5, INPUT_LAUNCH, 0.0f, target, 0.0, 0.0f});
+}
+
+// Plays matches headless with scripted launches, or driven by the autoplay paddle. Event-driven mode jumps from impact to impact;
+// frame-stepped mode runs the regular per-frame update at 60 Hz for comparison. Both use the same contact rules, but event-driven
+// mode resolves them in continuous time rather than at sub-step samples, so individual matches can still diverge.
+SimulationReport RunSimulation(int matchCount, unsigned int seed, bool eventDriven, bool autoplay) {
+    SimulationReport report = {0};
+    static GameStateData gameData;
+    gameData.autoplay.enabled = autoplay;
+    SetRandomSeed(seed);
+    for (int match = 0; match < matchCount; match++) {
+        RestartGame(&gameData);
+        game_state = GAME_PLAYING;
+        double matchStart = report.simulatedSeconds;
+        double simTime = matchStart;
+        while (game_state == GAME_PLAYING && simTime - matchStart < MAX_MATCH_SECONDS) {
+            if (autoplay) {
+                UpdateAutoplay(&gameData, simTime);
+            } else if (!gameData.ball.isActive && gameData.input.count == 0) {
+                ScheduleSimulatedLaunch(&gameData, simTime);
+            }
+            if (eventDriven) {
+                simTime += AdvanceToNextImpact(&gameData, simTime, MAX_MATCH_SECONDS - (float)(simTime - matchStart));
+            } else {
+                StepGame(&gameData, simTime, 1.0f / 60.0f);
+                simTime += 1.0f / 60.0f;
+            }
+            PumpAudio(simTime);
+            report.eventsProcessed++;
+        }
+        if (game_state == GAME_WON) report.matchesWon++;
+        else if (game_state == GAME_OVER) report.matchesLost++;
+        else report.matchesUnfinished++;
+        report.blocksDestroyed += gameData.rowCount * gameData.columnCount - gameData.blocks.count;
+        report.simulatedSeconds = simTime;
+    }
+    game_state = GAME_START;
+    return report;
+}
+
+int RunSimulationCommand(int matchCount, bool eventDriven, bool autoplay) {
+    telemetry.lossless = true;
+    // GetTime() only runs once a window exists, so the headless run times itself.
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    SimulationReport report = RunSimulation(matchCount, 1, eventDriven, autoplay);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("%s: %d matches (%d won, %d lost, %d unfinished), %d blocks destroyed\n",
+           eventDriven ? "event-driven" : "frame-stepped", matchCount,
+           report.matchesWon, report.matchesLost, report.matchesUnfinished, report.blocksDestroyed);
+    printf("%lld steps, %.1f s simulated in %.3f s\n", report.eventsProcessed, report.simulatedSeconds, elapsed);
+    StopTelemetry();
+    StopAudio();
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    bool autoplay = false;
+    bool dynamicResolution = true;
+    bool fixedStep = false;
+    bool hidden = false;
+    const char *captureDirectory = NULL;
+    const char *captureVideo = NULL;
+    int captureFrameLimit = 0;
+    AudioBackend audioBackend = AUDIO_BACKEND_DEVICE;
+    const char *wavPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--autoplay") == 0) autoplay = true;
+        if (strcmp(argv[i], "--audio-null") == 0) audioBackend = AUDIO_BACKEND_NULL;
+        if (strcmp(argv[i], "--native-resolution") == 0) dynamicResolution = false;
+        if (strcmp(argv[i], "--fixed-step") == 0) fixedStep = true;
+        if (strcmp(argv[i], "--hidden") == 0) hidden = true;
+    }
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--telemetry") == 0 && !StartTelemetry(argv[i + 1])) {
+            fprintf(stderr, "could not open telemetry log %s\n", argv[i + 1]);
+        }
+        if (strcmp(argv[i], "--capture-dir") == 0) captureDirectory = argv[i + 1];
+        if (strcmp(argv[i], "--capture-video") == 0) captureVideo = argv[i + 1];
+        if (strcmp(argv[i], "--capture-frames") == 0) captureFrameLimit = atoi(argv[i + 1]);
+        if (strcmp(argv[i], "--audio-wav") == 0) {
+            audioBackend = AUDIO_BACKEND_WAV;
+            wavPath = argv[i + 1];
+        }
+    }
+    if (audioBackend != AUDIO_BACKEND_DEVICE && !StartAudio(audioBackend, wavPath)) {
+        fprintf(stderr, "could not open audio output %s\n", wavPath);
+    }
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--simulate") == 0) return RunSimulationCommand(atoi(argv[i + 1]), true, autoplay);
+        if (strcmp(argv[i], "--simulate-frames") == 0) return RunSimulationCommand(atoi(argv[i + 1]), false, autoplay);
+    }
+
+    if (hidden) SetConfigFlags(FLAG_WINDOW_HIDDEN);
     InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Block Kuzuchi");
+    bool capturing = captureDirectory != NULL || captureVideo != NULL;
+    if (capturing && !StartCapture(captureDirectory, captureVideo, fixedStep)) {
+        fprintf(stderr, "could not start frame capture\n");
+        StopAudio();
+        CloseWindow();
+        StopTelemetry();
+        return 1;
+    }
+    if (capturing) dynamicResolution = false;
+    if (audioBackend == AUDIO_BACKEND_DEVICE) StartAudio(AUDIO_BACKEND_DEVICE, NULL);
+    ResolutionScaler scaler = InitResolutionScaler(dynamicResolution);
 
-    GameStateData gameData;
+    GameStateData gameData = {0};
+    gameData.autoplay.enabled = autoplay;
     RestartGame(&gameData);
 
+    long long frameCount = 0;
     while (!WindowShouldClose()) {
-        float deltaTime = GetFrameTime();
+        float deltaTime = fixedStep ? FRAME_BUDGET : GetFrameTime();
+        double tickStart = fixedStep ? frameCount * (double)FRAME_BUDGET : GetTime() - deltaTime;
+        frameCount++;
+        gameClock = tickStart;
+        PushTelemetry(TELEMETRY_FRAME, deltaTime);
+        PumpAudio(gameClock);
 
-        UpdateGameState(&gameData, deltaTime);
+        if (!gameData.autoplay.enabled) SampleInput(&gameData.input, tickStart, deltaTime);
+        if (IsKeyPressed(KEY_F4)) gameData.autoplay.enabled = !gameData.autoplay.enabled;
+        if (IsKeyPressed(KEY_F3)) gameData.latency.showOverlay = !gameData.latency.showOverlay;
+        UpdateGameState(&gameData, tickStart, deltaTime);
 
+        if (game_state == GAME_PLAYING) DrawScaledGame(&scaler, &gameData);
         BeginDrawing();
         switch (game_state) {
             case GAME_START:
@@ -443,7 +1901,12 @@ int main(void) {
                 break;
 
             case GAME_PLAYING:
-                DrawGame(&gameData.player, &gameData.ball, gameData.blocks, gameData.rowCount, gameData.columnCount, gameData.powerUps);
+                PresentScaledGame(&scaler);
+                DrawLifebar(&gameData.player);
+                if (gameData.latency.showOverlay) {
+                    DrawLatencyOverlay(&gameData.latency);
+                    DrawResolutionOverlay(&scaler);
+                }
                 break;
 
             case GAME_OVER:
@@ -459,10 +1922,22 @@ int main(void) {
             default:
                 break;
         }
+        CaptureFrame();
+        double presentStart = GetTime();
         EndDrawing();
+        double presentEnd = GetTime();
+        RecordPresentLatency(&gameData.latency, presentEnd);
+        if (game_state == GAME_PLAYING) UpdateResolutionScale(&scaler, presentEnd, presentEnd - presentStart);
+        // Readbacks still in flight are collected by StopCapture, so they count toward the limit.
+        int framesRead = capture.capturedFrames + capture.readbackCount;
+        if (captureFrameLimit > 0 && (framesRead >= captureFrameLimit || atomic_load(&capture.failed))) break;
     }
+    StopCapture();
+    UnloadRenderTexture(scaler.target);
+    StopAudio();
     CloseWindow();
-    return 0;
+    StopTelemetry();
+    return atomic_load(&capture.failed) ? 1 : 0;
 }
 
 